@@ -0,0 +1,123 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include "heapfile.h"
+
+// define if debug output wanted
+//#define DEBUGIND
+
+// A B+-tree index maps the values of one attribute of a heap file to
+// the RIDs of the records holding them. It is a file of its own, kept
+// in buffer pool pages. Entries are ordered by key and then by RID, so
+// each one is unique even if keys repeat. The leaves are chained left
+// to right for range scans. Deletes do not merge nodes, so a leaf can
+// be left empty; inserts fill it again.
+
+const int BT_MAGIC = 0x42543031;
+const int BT_MAXKEYLEN = 256;		// longest key
+const int BT_MAXHEIGHT = 32;		// most levels a tree can have
+
+struct BTHdrPage
+{
+  int		magic;		// BT_MAGIC
+  int		keyType;	// Datatype of the keys
+  int		keyLen;		// key length in bytes
+  int		root;		// page number of the root node
+  int		height;		// number of levels, 1 if the root is a leaf
+  int		entryCnt;	// number of entries
+};
+
+// A node. A leaf holds count entries of key and RID. An inner node
+// holds the page number of its leftmost child, then count entries of
+// key, RID and the child with the entries from that one on.
+struct BTNode
+{
+  int		level;		// 0 for a leaf
+  int		count;		// number of entries
+  int		next;		// next leaf to the right, -1 if none
+  char		data[PAGESIZE - 3 * sizeof(int)];
+};
+
+
+// create an empty index file for keys of type type and keyLen bytes;
+// FILEEXISTS if there is a file by that name
+const Status createBTreeIndex(const string & fileName,
+			      const Datatype type,
+			      const int keyLen);
+
+class BTreeIndex : public AttrIndex
+{
+public:
+  // open an index file made by createBTreeIndex
+  BTreeIndex(const string & fileName, Status & status);
+
+  // end any scan and close the file
+  ~BTreeIndex();
+
+  // add the entry of the record at rid, whose attribute value is key
+  const Status insertEntry(const void* key, const RID & rid);
+
+  // remove that entry; RECNOTFOUND if there is none
+  const Status deleteEntry(const void* key, const RID & rid);
+
+  // start a scan of the entries with keys from lowVal to highVal in
+  // key order. lowOp is GT or GTE and highOp LT or LTE; a NULL value
+  // leaves that end open. The values are copied.
+  const Status startScan(const void* lowVal, const Operator lowOp,
+			 const void* highVal, const Operator highOp);
+
+  // return the RID of the next entry of the scan; FILEEOF at the end
+  const Status scanNext(RID & rid);
+
+  // end the scan
+  const Status endScan();
+
+  // return number of entries in the index
+  const int getEntryCnt() const;
+
+private:
+  File*		file;
+  BTHdrPage*	hdr;		// pinned header page
+  int		hdrPageNo;
+  bool		hdrDirty;
+  Datatype	keyType;
+  int		keyLen;
+  int		leafSize;	// bytes of a leaf entry
+  int		innerSize;	// bytes of an inner node entry
+  int		leafMax;	// entries a leaf has room for
+  int		innerMax;	// entries an inner node has room for
+
+  BTNode*	scanLeaf;	// leaf the scan is on, pinned; NULL if none
+  int		scanPageNo;
+  int		scanPos;	// next entry of scanLeaf
+  bool		scanHigh;	// the scan has an upper end
+  Operator	highOp;
+  char		highKey[BT_MAXKEYLEN];
+
+  char* leafEntry(BTNode* node, const int i) const
+    { return node->data + i * leafSize; }
+  char* innerEntry(BTNode* node, const int i) const
+    { return node->data + sizeof(int) + i * innerSize; }
+  int child(BTNode* node, const int i) const;
+
+  int cmpKey(const char* a, const char* b) const;
+  int cmpEntry(const char* a, const char* b) const;
+
+  // number of entries of an inner node that are at most entry, which
+  // is the child to follow for it
+  int innerFind(BTNode* node, const char* entry) const;
+
+  // number of entries of a leaf that are less than entry
+  int leafFind(BTNode* node, const char* entry) const;
+
+  // find the leaf entry belongs on, reading it into node; the page
+  // numbers of the nodes on the way down go into path by level
+  const Status findLeaf(const char* entry, int path[], BTNode*& node);
+
+  // add entry, with child page childNo, to the inner node at level
+  // of path, splitting nodes up to the root as needed
+  const Status insertInner(const int path[], int level, char* entry,
+			   int childNo);
+};
+
+#endif
@@ -1,30 +1,71 @@
 #ifndef BUF_H
 #define BUF_H
 
+#include <pthread.h>
+#include <map>
 #include "db.h"
+#include "ioqueue.h"
 // define if debug output wanted
 //#define DEBUGBUF
 
-// declarations for buffer pool hash table
+// number of buffer frames used unless a pool size is given
+#define BUFS_DEFAULT       100
+
+// read-ahead window (in pages) used unless overridden via setReadAhead()
+#define READAHEAD_DEFAULT  16
+#define READAHEAD_MAX      64
+
+// read-ahead runs that may be in flight at once; together they never
+// hold more than half of the pool
+#define READAHEAD_SLOTS    8
+
+// number of independently latched partitions of the buffer hash table
+// (a power of two)
+#define BUFHASH_PARTS      16
+
+// the background writer starts cleaning once more than 1/FLUSH_HIGH
+// of the pool is dirty; it writes at most FLUSH_RUN_MAX adjacent pages
+// with one call
+#define FLUSH_HIGH         4
+#define FLUSH_RUN_MAX      64
+
+// runs that one bulk write keeps in flight
+#define FLUSH_INFLIGHT     32
+
+// operations on files larger than 1/RING_THRESHOLD of the pool recycle
+// a ring of at most RING_MAX frames (see BufRing)
+#define RING_THRESHOLD     4
+#define RING_MAX           64
+#define RING_RUNS          4      // writes of ring pages in flight
+
+// declarations for buffer pool hash table. The table is open
+// addressed: a slot with file == NULL is empty.
 struct hashBucket
 {
 	File*	file;    // pointer a file object (more on this below)
 	int	pageNo;  // page number within a file
 	int	frameNo; // frame number of page in the buffer pool
-	hashBucket* 	next;	 // next node in the hash table
 };
 
 
-// hash table to keep track of pages in the buffer pool
+// hash table to keep track of pages in the buffer pool. All slots are
+// allocated up front (at least twice the number of entries it is
+// expected to hold, rounded up to a power of two) and collisions are
+// resolved by linear probing, so insert and remove do not touch the
+// heap unless the table has to grow past half full. The table itself
+// is not latched; BufMgr keeps one per partition, each with a latch.
 class BufHashTbl
 {
 private:
-    int HTSIZE;
-    hashBucket**  ht; // actual hash table
+    int HTSIZE;       // number of slots, a power of two
+    int mask;         // HTSIZE - 1
+    int count;        // slots in use
+    hashBucket*  ht;  // actual hash table
     int	 hash(const File* file, const int pageNo); // returns value between 0 and HTSIZE-1
+    void grow();      // double the number of slots
 
 public:
-    BufHashTbl(const int htSize);  // constructor
+    BufHashTbl(const int maxEntries);  // constructor
     ~BufHashTbl(); // destructor
 	
     // insert entry into hash table mapping (file,pageNo) to frameNo;
@@ -43,10 +84,23 @@ public:
 
 
 class BufMgr;  //forward declaration of BufMgr class 
+class ReplPolicy;
+struct FlushEntry;
+struct WriteRun;
+struct ReadAhead;
+
+// page replacement policies the buffer manager can be configured with
+// (see replace.h)
+enum ReplPolicyType { CLOCK_POLICY, TWOQ_POLICY, CLOCKPRO_POLICY };
 
-// class for maintaining information about buffer pool frames
+// class for maintaining information about buffer pool frames.
+// pinCnt is only changed with atomic operations and only raised while
+// holding the latch of the hash partition the page is in, so a page
+// that is found in the hash table cannot be evicted before it is
+// pinned.
 class BufDesc {
     friend class BufMgr;
+    friend class ReplPolicy;
 private:
   File* file;   // pointer to file object
   int   pageNo; // page within file
@@ -55,6 +109,8 @@ private:
   bool 	dirty;	  // true if dirty;  false otherwise
   bool 	valid;   // true if page is valid
   bool  refbit;	 // has this buffer frame been reference recently
+  bool  prefetched; // read ahead and not requested by anybody yet
+  int   ioSlot;   // read-ahead request still filling the frame, or -1
 
   void Clear() {  // initialize buffer frame for a new user
     	pinCnt = 0;
@@ -62,6 +118,8 @@ private:
 	pageNo = -1;
     	dirty = false;
 	valid = false;
+	prefetched = false;
+	ioSlot = -1;
   };
 
   void Set(File* filePtr, int pageNum) { 
@@ -71,6 +129,8 @@ private:
       dirty = false;
       valid = true;
       refbit = true;
+      prefetched = false;
+      ioSlot = -1;
   }
 
   BufDesc() {
@@ -79,15 +139,62 @@ private:
 };
 
 
+// A small private set of frames that one bulk operation (a scan or a
+// load of a big file) recycles over and over, so that touching every
+// page once does not push everybody else's pages out of the pool.
+// Frames leave the ring again when somebody else gets hold of them.
+// Rings are handed out by BufMgr::newRing and used by one thread.
+
+struct RingEntry
+{
+  int	frame;	// -1 if unused
+  File*	file;	// page the ring put into frame
+  int	pageNo;
+};
+
+class BufRing
+{
+  friend class BufMgr;
+private:
+  int		size;
+  int		next;		// entry to recycle next
+  RingEntry*	entries;
+  FlushEntry*	flushList;	// for writing back dirty ring pages
+  WriteRun*	writeRuns;
+
+  BufRing(const int size);
+public:
+  ~BufRing();
+};
+
+
+// Buffer pool statistics, kept for the whole pool and for each file.
+// Counters are updated with atomic adds; reading them while other
+// threads use the pool gives approximate values.
 struct BufStats
 {
-  int accesses;    // Total number of accesses to buffer pool
-  int diskreads;   // Number of pages read from disk (including allocs)
-  int diskwrites;  // Number of pages written back to disk
+  long long accesses;    // Total number of accesses to buffer pool
+  long long hits;        // Page requests found in the pool
+  long long misses;      // Page requests that had to go to disk
+  long long diskreads;   // Number of pages read from disk (including allocs)
+  long long diskwrites;  // Number of pages written back to disk
+  long long bytesRead;   // Bytes read from disk
+  long long bytesWritten; // Bytes written to disk
+  long long evictions;   // Pages thrown out to make room for another
+  long long dirtyEvicts; // Dirty victims that had to be written on eviction
+  long long pinFailures; // Requests refused because every frame was pinned
+  long long raPages;     // Number of pages brought in by read-ahead
+  long long raHits;      // Read-ahead pages that were later requested
+  long long raMisses;    // Read-ahead pages evicted without ever being used
+  long long bgWrites;    // Pages written back by the background writer
 
   void clear()
     {
-      accesses = diskreads = diskwrites = 0;
+      accesses = hits = misses = 0;
+      diskreads = diskwrites = bytesRead = bytesWritten = 0;
+      evictions = dirtyEvicts = pinFailures = 0;
+      raPages = raHits = raMisses = 0;
+      bgWrites = 0;
     }
       
   BufStats()
@@ -97,44 +204,175 @@ struct BufStats
 };
 
 
+// The buffer manager may be shared by several threads. Lookups of
+// resident pages only take the latch of one hash partition. Anything
+// that assigns a page to a frame or empties a frame (misses,
+// read-ahead, allocPage, disposePage, flushFile) as well as the
+// replacement policy run under poolLatch, which is acquired before
+// any partition latch.
+//
+// A background writer thread cleans dirty pages in bulk so that
+// victims are usually clean. It and flushFile hold flushLatch (taken
+// before poolLatch) while they write.
+//
+// Bulk writes and read-ahead go through an IOQueue and keep many
+// requests in flight. Read-ahead pages are hashed as soon as their
+// read is started, pinned on behalf of the read; readers never pin
+// such a page but wait for the read under poolLatch.
 class BufMgr 
 {
 private:
-  unsigned int 	 clockHand;
   int   	 numBufs;    	// Number of pages in buffer pool
-  BufHashTbl*    hashTable;  	// hash table mapping (File, page) to frame
+  BufHashTbl*    hashTable[BUFHASH_PARTS]; // hash partitions mapping (File, page) to frame
+  pthread_mutex_t hashLatch[BUFHASH_PARTS]; // one latch per partition
+  pthread_mutex_t poolLatch;	// frame assignment and replacement
+
+  pthread_t	 flusher;	// background writer
+  pthread_mutex_t flushLatch;	// held while pages are written in bulk
+  pthread_mutex_t flushWait;	// protects the two flags, used with flushCond
+  pthread_cond_t flushCond;	// wakes the background writer
+  bool		 flusherStop;	// tells the background writer to exit
+  int		 dirtyCnt;	// # frames marked dirty (approximate)
+  bool		 flushRequested; // background writer has work to do
+  FlushEntry*	 flushList;	// scratch list of frames being written
+  WriteRun*	 writeRuns;	// writes in flight, under flushLatch
+
+  IOQueue*	 ioQueue;	// asynchronous reads and writes
+  ReadAhead*	 raSlots;	// read-ahead in flight, under poolLatch
+  int		 raNextSlot;	// slot to reuse next
+  int		 raInFlight;	// # pages being read ahead
+
+  map<string, BufStats> fileStats; // statistics per file name
+  pthread_mutex_t statsLatch;	// protects fileStats
+  string	 statsDump;	// file the statistics are dumped to at exit
   BufDesc*	 bufTable;  	// vector of status info, 1 per page
   BufStats	 bufStats;	// buffer pool statistics
+  int		 readAheadWindow; // max. # of pages fetched ahead, 0 = off
+  ReplPolicy*	 policy;	// chooses the frame to reuse on a miss
+  size_t	 poolBytes;	// size of the mmap()ed pool, 0 if not mapped
 
   const Status allocBuf(int & frame);   // allocate a free frame.  
+  const Status evictFrame(const int frame); // write back and empty a victim
+
+  // allocBuf for (file, pageNo), recycling a frame of ring if possible
+  const Status allocBuf(int & frame, BufRing* ring, File* file,
+                        const int pageNo);
+  // write back the dirty, unpinned pages of ring
+  void flushRing(BufRing* ring);
   const void releaseBuf(int frame); // return unused frame to end of list
-  void advanceClock()
-  {
-	clockHand = (clockHand + 1) % numBufs;
-  }
+  void clearBuf(int frame);	// empty a frame whose page is not replaced
+
+  // hash partition (file, pageNo) belongs to
+  int part(const File* file, const int pageNo) const;
+
+  // latched hash table operations
+  const Status lookupFrame(const File* file, const int pageNo, int& frame);
+  const Status insertFrame(const File* file, const int pageNo, const int frame);
+  const Status removeFrame(const File* file, const int pageNo);
+
+  // if (file, pageNo) is resident, pin it and return its frame
+  bool pinResident(const File* file, const int pageNo, int& frame);
+
+  // unhash the page in frame unless it is pinned
+  bool unhashUnpinned(const int frame);
+
+  // background writer
+  static void* flusherMain(void* arg);
+  void wakeFlusher();
+  const Status cleanDirty();
+
+  // write out the first count frames on flushList in (file, pageNo)
+  // order, merging adjacent pages of a file into one write
+  const Status writeFrames(FlushEntry* list, const int count,
+			   WriteRun* runs, const int numRuns,
+			   const bool background);
+
+  // wait for a write started by writeFrames and check its outcome
+  const Status finishWrite(WriteRun* run, const bool background);
+
+  // wait for a read-ahead request and make its pages available;
+  // caller holds poolLatch
+  void finishReadAhead(const int slot);
+
+  // finish all read-ahead requests (of file, or of any file if file
+  // is NULL) if wait is true, otherwise just those already complete
+  void finishReadAheads(const File* file, const bool wait);
+
+  // if (file, pageNo) is still being read ahead, wait for it
+  void waitReadAhead(const File* file, const int pageNo);
 
+  // statistics of file, created on first use
+  BufStats* statsOf(File* file);
+
+  // add n to a counter in the totals and (if file is not NULL) in the
+  // statistics of file
+  void count(File* file, long long BufStats::*counter, const long long n);
+
+  // rest of readPage once the page has been found and pinned
+  const Status readPageHit(File* file, const int PageNo, const int frame,
+                           const bool sequential, BufRing* ring, Page*& page);
+
+  // read the run of pages starting at pageNo into free frames with
+  // one vectored read; if frame is not NULL, pageNo is the page the
+  // caller asked for and its frame is returned pinned. Otherwise the
+  // read is only started.
+  const Status readRun(File* file, const int pageNo, int* frame,
+                       BufRing* ring);
+
+  // start reading count pages from pageNo into frames
+  const Status startReadAhead(File* file, const int pageNo, int count,
+                              BufRing* ring);
 
 public:
   Page*	         bufPool;   // actual buffer pool
 
-  BufMgr(const int bufs);
+  // hugePages asks the kernel to back the pool with huge pages
+  BufMgr(const int bufs, const ReplPolicyType policyType = CLOCK_POLICY,
+         const bool hugePages = false,
+         const IOBackendType ioBackend = IO_AUTO);
   ~BufMgr();
 
-  const Status readPage(File* file, const int PageNo, Page*& page);
+  // pages are read into (allocated in) frames of ring if it is given
+  const Status readPage(File* file, const int PageNo, Page*& page,
+                        BufRing* ring = NULL);
   const Status unPinPage(File* file, const int PageNo, const bool dirty);
-  const Status allocPage(File* file, int& PageNo, Page*& page); 
+  const Status allocPage(File* file, int& PageNo, Page*& page,
+                         BufRing* ring = NULL);
                         // allocates a new, empty page 
+
+  // a ring for an operation that will go through filePages pages of a
+  // file once, or NULL if that many pages fit in the pool comfortably.
+  // The caller deletes the ring when done.
+  BufRing* newRing(const int filePages);
   const Status flushFile(const File* file); // writing out all dirty pages of the file
   const Status disposePage(File* file, const int PageNo); // dispose of page in file
   void  printSelf();
 
+  // set the read-ahead window in pages (0 disables read-ahead)
+  void  setReadAhead(const int pages);
+
+  // tell the buffer manager that file is (or no longer is) being
+  // scanned sequentially so that it reads ahead from the first miss on
+  void  hintSequential(File* file, const bool sequential);
+
+  int   getNumBufs() const { return numBufs; } // frames in the pool
+
   const BufStats & getBufStats() const // get buffer pool usage
   {
 	return bufStats;
   }
-  const void clearBufStats() 
+  void clearBufStats();		// reset the totals and every file's counters
+
+  // print the totals and a line per file in a table
+  void printStats();
+
+  // write all counters as comma separated values to fileName
+  const Status dumpStats(const string & fileName);
+
+  // dump the statistics to fileName when the buffer manager goes away
+  void setStatsDump(const string & fileName)
   {
-	bufStats.clear();
+	statsDump = fileName;
   }
 };
 
@@ -70,6 +70,7 @@ class RelCatalog : public HeapFile {
 //   attribute number : integer(4)
 //   attribute type : integer(4)  (type is Datatype actually)
 //   attribute size : integer(4)
+//   index type : integer(4)  (type is IndexType actually)
 
 
 typedef struct {
@@ -78,6 +79,7 @@ typedef struct {
   int attrOffset;                       // attribute offset
   int attrType;                         // attribute type
   int attrLen;                          // attribute length
+  int indexed;                          // index on attribute, IX_NONE if none
 } AttrDesc;
 
 
@@ -99,6 +101,11 @@ class AttrCatalog : public HeapFile {
   // remove tuple from catalog
   const Status removeInfo(const string & relation, const string & attrName);
 
+  // record that attribute has an index of type indexed, or none
+  const Status setIndexed(const string & relation,
+			  const string & attrName,
+			  const int indexed);
+
   // get all attributes of a relation
   const Status getRelInfo(const string & relation, 
 			  int &attrCnt, 
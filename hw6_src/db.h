@@ -2,6 +2,7 @@
 #define DB_H
 
 #include <sys/types.h>
+#include <pthread.h>
 #include <functional>
 #include "error.h"
 #include <string.h>
@@ -12,22 +13,50 @@ using namespace std;
 //#define DEBUGIO
 //#define DEBUGFREE
 
+// alignment of the buffer pool and of the bounce buffers used for
+// direct I/O
+#define DIRECT_ALIGN 4096
+
+// structure of DB (header) page
+
+typedef struct {
+  int nextFree;                         // page # of next page on free list
+  int firstPage;                        // page # of first page in file
+  int numPages;                         // total # of pages in file
+  int pageSize;                         // PAGESIZE the file was created
+                                        // with; 0 in old files (1K)
+} DBPage;
+
 // forward class definition for db
 class DB;
+struct BufStats;
+struct IORequest;
 
 // class definition for open files
 class File {
   friend class DB;
   friend class OpenFileHashTbl;
+  friend class BufMgr;
 
  public:
 
-  Status allocatePage(int& pageNo);     // allocate a new page
+  Status allocatePage(int& pageNo,
+		      const int extent = 1);  // allocate a new page; grow
+					// the file by extent pages if full
+  Status allocatePages(const int count,
+		       int& firstPageNo);     // allocate a run of pages
   const Status disposePage(const int pageNo);       // release space for a page
   const Status readPage(const int pageNo,
 		  Page* pagePtr) const;       // read page from file
   const Status writePage(const int pageNo,
 		   const Page* pagePtr);      // write page to file
+  const Status readPages(const int pageNo, const int count,
+		   Page* pages[], int& pagesRead) const; // vectored read of a run
+  const Status writePages(const int pageNo, const int count,
+		   Page* pages[]);           // vectored write of a run
+  const Status prepareIO(IORequest* req, const int pageNo, const int count,
+		   Page* pages[], const bool write) const; // set up an async transfer
+  const Status getNumPages(int& numPages) const; // # pages on disk
   const Status getFirstPage(int& pageNo) const;     // returns pageNo of first page
 
   bool operator == (const File & other) const
@@ -43,13 +72,20 @@ class File {
   static const Status create(const string &fileName);
   static const Status destroy(const string &fileName);
 
-  const Status open();
+  const Status open(const bool directIO);
   const Status close();
 
+  void enableDirect();                // switch to O_DIRECT if possible
+
   const Status intread(const int pageNo,
 		 Page* pagePtr) const;        // internal file read
   const Status intwrite(const int pageNo,
 		  const Page* pagePtr);       // internal file write
+  Status intallocate(int& pageNo, const int extent); // allocatePage, latch held
+  Status intextend(const int count, int& firstPageNo,
+		   const int extent);   // add pages at the end, latch held
+  const Status flushHeader();           // write back header, latch held
+  const Status intdispose(const int pageNo); // disposePage, latch held
 
 #ifdef DEBUGFREE
   void listFree();                      // list free pages
@@ -58,6 +94,22 @@ class File {
   string fileName;                    // The name of the file
   int openCnt;                        // # times file has been opened
   int unixFile;                       // unix file stream for file
+  bool direct;                        // opened with O_DIRECT
+  size_t directAlign;                 // buffer alignment O_DIRECT needs
+  pthread_mutex_t hdrLatch;           // serializes header page updates
+
+  // The header page is read when the file is opened and written back
+  // when it is closed; hdrLatch protects the copy.
+  DBPage header;
+  bool hdrDirty;                      // header differs from disk
+  int fileEnd;                        // # pages the unix file has room for
+
+  // read-ahead state, maintained by the buffer manager
+  int raLastPage;                     // last page requested through readPage
+  int raNextPage;                     // first page past the last read-ahead
+  int raScans;                        // # sequential scans hinted on file
+
+  BufStats* stats;                    // buffer statistics, owned by BufMgr
 };
 
 class BufMgr;
@@ -98,6 +150,9 @@ public:
 
 
 
+// All DB operations are serialized by one latch so that threads can
+// open and close files concurrently.
+
 class DB {
  public:
   DB();                                 // initialize open file table
@@ -106,20 +161,20 @@ class DB {
   const Status createFile(const string & fileName) ;  // create a new file
   const Status destroyFile(const string & fileName) ; // destroy a file, 
                                                            // release all space
+  const Status replaceFile(const string & fileName,  // rename newFileName
+			   const string & newFileName); // over fileName
   const Status openFile(const string & fileName, File* & file);  // open a file
   const Status closeFile(File* file);         // close a file
 
+  // open files from now on with O_DIRECT, bypassing the kernel's page
+  // cache, where the file system allows it
+  void setDirectIO(const bool on) { directIO = on; }
+
  private:
   OpenFileHashTbl   openFiles;    // list of open files
+  pthread_mutex_t   latch;        // protects openFiles and open counts
+  bool              directIO;     // open files with O_DIRECT
 };
 
 
-// structure of DB (header) page
-
-typedef struct {
-  int nextFree;                         // page # of next page on free list
-  int firstPage;                        // page # of first page in file
-  int numPages;                         // total # of pages in file
-} DBPage;
-
 #endif
@@ -0,0 +1,51 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include "heapfile.h"
+
+// Vectorized evaluation of one predicate over a page's worth of
+// 4-byte attribute values, producing a selection bitmap. Used by
+// HeapFileScan for INTEGER and FLOAT predicates.
+
+enum FilterImpl { FILTER_AUTO, FILTER_SCALAR, FILTER_SSE, FILTER_AVX2 };
+
+// maps "auto", "scalar", "sse" and "avx2" to an implementation;
+// returns BADFILTERIMPL for anything else
+const Status parseFilterImpl(const char* name, FilterImpl& impl);
+
+// selects the implementation used from now on; FILTER_AUTO takes the
+// best one the CPU supports, which is also the default. Returns
+// BADFILTERIMPL if the CPU cannot run the one asked for.
+const Status setFilterImpl(const FilterImpl impl);
+
+// the implementation in use, never FILTER_AUTO
+const FilterImpl getFilterImpl();
+
+// attr op fltr; OP is a template parameter so each instance is a
+// single compare
+template <Operator OP, class T>
+inline bool compare(const T attr, const T fltr)
+{
+  switch (OP)
+  {
+  case LT:  return attr < fltr;
+  case LTE: return attr <= fltr;
+  case EQ:  return attr == fltr;
+  case GTE: return attr >= fltr;
+  case GT:  return attr > fltr;
+  case NE:  return attr != fltr;
+  }
+  return false;
+}
+
+// number of 32-bit words in the bitmap for n values
+#define SELWORDS(n)	(((n) + 31) / 32)
+
+// Sets bit i of sel (bit i % 32 of word i / 32) iff vals[i] op value,
+// for i < n; returns the number of bits set.
+const int filterInts(const Operator op, const int value,
+		     const int vals[], const int n, unsigned sel[]);
+const int filterFloats(const Operator op, const float value,
+		       const float vals[], const int n, unsigned sel[]);
+
+#endif
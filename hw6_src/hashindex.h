@@ -0,0 +1,122 @@
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+#include <vector>
+#include "heapfile.h"
+
+// define if debug output wanted
+//#define DEBUGIND
+
+// An extendible hash index maps the values of one attribute of a heap
+// file to the RIDs of the records holding them, for equality lookups.
+// It is a file of its own, kept in buffer pool pages. A directory of
+// 2^depth slots, spread over directory pages, names the bucket for
+// each value of the low depth bits of a key's hash; a bucket whose own
+// depth is less than that is named by several slots. A full bucket is
+// split in two on the next bit, doubling the directory first if its
+// depth is already the directory's. Entries whose hashes cannot be
+// told apart (repeated keys) go on overflow pages chained to their
+// bucket instead. Deletes do not merge buckets or shrink the directory.
+
+const int HX_MAGIC = 0x48583031;
+const int HX_MAXKEYLEN = 256;		// longest key
+const int HX_MAXDEPTH = 30;		// most hash bits a directory uses
+const int HX_DIRSLOTS = PAGESIZE / sizeof(int);	// slots per directory page
+const int HX_MAXDIRPAGES = (PAGESIZE - 6 * sizeof(int)) / sizeof(int);
+
+struct HXHdrPage
+{
+  int		magic;		// HX_MAGIC
+  int		keyType;	// Datatype of the keys
+  int		keyLen;		// key length in bytes
+  int		depth;		// hash bits the directory uses
+  int		entryCnt;	// number of entries
+  int		dirCnt;		// number of directory pages
+  int		dir[HX_MAXDIRPAGES];	// page numbers of the directory pages
+};
+
+// A bucket page, or an overflow page chained to one. It holds count
+// entries of key and RID.
+struct HXBucket
+{
+  int		depth;		// hash bits its keys have in common
+  int		count;		// number of entries
+  int		next;		// next overflow page, -1 if none
+  char		data[PAGESIZE - 3 * sizeof(int)];
+};
+
+
+// create an empty index file for keys of type type and keyLen bytes;
+// FILEEXISTS if there is a file by that name
+const Status createHashIndex(const string & fileName,
+			     const Datatype type,
+			     const int keyLen);
+
+class HashIndex : public AttrIndex
+{
+public:
+  // open an index file made by createHashIndex
+  HashIndex(const string & fileName, Status & status);
+
+  // end any scan and close the file
+  ~HashIndex();
+
+  // add the entry of the record at rid, whose attribute value is key
+  const Status insertEntry(const void* key, const RID & rid);
+
+  // remove that entry; RECNOTFOUND if there is none
+  const Status deleteEntry(const void* key, const RID & rid);
+
+  // start a scan of the entries with key value; the value is copied
+  const Status startScan(const void* value);
+
+  // return the RID of the next entry of the scan; FILEEOF at the end
+  const Status scanNext(RID & rid);
+
+  // end the scan
+  const Status endScan();
+
+  // return number of entries in the index
+  const int getEntryCnt() const;
+
+private:
+  File*		file;
+  HXHdrPage*	hdr;		// pinned header page
+  int		hdrPageNo;
+  bool		hdrDirty;
+  Datatype	keyType;
+  int		keyLen;
+  int		entrySize;	// bytes of an entry
+  int		bucketMax;	// entries a bucket page has room for
+  int		maxDepth;	// most bits the directory pages have room for
+
+  HXBucket*	scanPage;	// page the scan is on, pinned; NULL if none
+  int		scanPageNo;
+  int		scanPos;	// next entry of scanPage
+  char		scanKey[HX_MAXKEYLEN];
+
+  char* entry(HXBucket* b, const int i) const
+    { return b->data + i * entrySize; }
+
+  // hash of a key; keys that compare equal hash alike
+  unsigned int hash(const char* key) const;
+  bool sameKey(const char* a, const char* b) const;
+
+  // read and write directory slot slot
+  const Status getSlot(const int slot, int & pageNo);
+  const Status setSlot(const int slot, const int pageNo);
+
+  // double the directory; the new half names the same buckets
+  const Status grow();
+
+  // split the bucket at pageNo, which is pinned as b and is named by
+  // the slot for hash h
+  const Status split(const int pageNo, HXBucket* b, const unsigned int h);
+
+  // put the n entries at entries into the chain starting at b, which
+  // is pinned, taking overflow pages from spare or the file as needed
+  const Status fill(HXBucket* b, const char* entries, const int n,
+		    vector<int> & spare);
+};
+
+#endif
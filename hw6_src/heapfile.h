@@ -24,13 +24,124 @@ const unsigned MAXNAMESIZE = 50;
 enum Datatype { STRING, INTEGER, FLOAT };    // attribute data types
 enum Operator { LT, LTE, EQ, GTE, GT, NE };  // scan operators
 
-struct FileHdrPage
+// The free-space map keeps one byte per page of the file: the free
+// space on the page in units of FSM_UNIT bytes, rounded down. It is
+// stored on map pages listed in the header page; pages beyond what
+// FSM_MAXPAGES map pages cover are not tracked.
+const unsigned FSM_UNIT = PAGESIZE / 256;
+const int FSM_ENTRIES = PAGESIZE;		// pages covered per map page
+const int FSM_MAGIC = 0x46534d31;
+
+// Zone maps keep the smallest and largest value of an INTEGER or FLOAT
+// attribute on each page, so that scans can pass over pages that
+// cannot satisfy their filter. A link map next to them holds each data
+// page's next page, which lets a scan step over a page without reading
+// it. Each map is a page map: a fixed-size entry per page number, on
+// map pages listed on a directory page. Pages beyond what one
+// directory page covers are not tracked.
+const int ZM_MAXATTRS = 4;		// zone-mapped attributes per file
+const int ZM_MAGIC = 0x5a4d3031;
+
+struct ZoneAttr
+{
+  int		offset;		// attribute offset in the record
+  int		type;		// INTEGER or FLOAT
+  int		dirPage;	// directory page of its zone map
+};
+
+// zone map entry: lo > hi for a page without records, the type's full
+// range for one that is not summarized
+union ZoneVal
+{
+  int		i;
+  float		f;
+};
+
+struct ZoneEntry
+{
+  ZoneVal	lo;
+  ZoneVal	hi;
+};
+
+// The page directory lists the data pages in chain order, so that
+// the k-th page can be found without walking the chain to it. It is a
+// page map indexed by that position, holding page numbers.
+const int PD_MAXPAGES = (PAGESIZE / sizeof(int)) * (PAGESIZE / sizeof(int));
+const int PD_MAGIC = 0x50443031;
+
+// An index on an attribute is a file of its own, named by
+// indexFileName, and is kept up to date by every insert and delete.
+// The header lists the indexed attributes.
+const int IX_MAXATTRS = 4;		// indexed attributes per file
+const int IX_MAGIC = 0x49583031;
+
+enum IndexType { IX_NONE, IX_BTREE, IX_HASH };
+
+struct IndexAttr
+{
+  int		offset;		// attribute offset in the record
+  int		type;		// Datatype of the attribute
+  int		length;		// attribute length
+  int		kind;		// IndexType
+};
+
+// name of the index file on the attribute at offset of a heap file
+const string indexFileName(const string & fileName, const int offset);
+
+// What a heap file needs of an index to keep it up to date; each
+// kind of index implements it, along with its own way of lookup.
+class AttrIndex
+{
+public:
+  virtual ~AttrIndex() {}
+
+  // add the entry of the record at rid, whose attribute value is key
+  virtual const Status insertEntry(const void* key, const RID & rid) = 0;
+
+  // remove that entry; RECNOTFOUND if there is none
+  virtual const Status deleteEntry(const void* key, const RID & rid) = 0;
+};
+
+// The header page is its fixed fields followed by the list of map
+// pages, which takes up the rest of the page.
+struct FileHdrFields
 {
   char		fileName[MAXNAMESIZE];   // name of file
   int		firstPage;	// pageNo of first data page in file
   int		lastPage;	// pageNo of last data page in file
   int		pageCnt;	// number of pages
   int		recCnt;		// record count
+  int		fsmMagic;	// FSM_MAGIC once the fields below are set up
+  int		fsmHint;	// no page below this one is known to have room
+  int		fsmCnt;		// number of map pages
+  int		zmMagic;	// ZM_MAGIC once the fields below are set up
+  int		zmCnt;		// number of zone-mapped attributes
+  int		zmLinkDir;	// directory page of the link map, 0 if none
+  ZoneAttr	zmAttrs[ZM_MAXATTRS];
+  int		pdMagic;	// PD_MAGIC once the page directory is built
+  int		pdDir;		// directory page of the page directory
+  int		ixMagic;	// IX_MAGIC once the fields below are set up
+  int		ixCnt;		// number of indexed attributes
+  IndexAttr	ixAttrs[IX_MAXATTRS];
+};
+
+const int FSM_MAXPAGES = (PAGESIZE - sizeof(FileHdrFields)) / sizeof(int);
+
+struct FileHdrPage : public FileHdrFields
+{
+  int		fsmPages[FSM_MAXPAGES];	// pageNos of the map pages
+};
+
+static_assert(FSM_MAXPAGES > 0 && sizeof(FileHdrPage) <= PAGESIZE,
+	      "file header does not fit on a page");
+
+// A page map page held pinned across lookups
+struct MapCursor
+{
+  int		k;		// index of the map page, -1 if none
+  int		pageNo;
+  Page*		page;
+  bool		dirty;
 };
 
 
@@ -46,6 +157,59 @@ protected:
    int   	curPageNo;	// page number of pinned page
    bool  	curDirtyFlag;   // true if page has been updated
    RID   	curRec;         // rid of last record returned
+   BufRing*	ring;		// frames of a bulk scan or load, or NULL
+   string	fileName;	// name the file was opened by
+   AttrIndex*	indexes[IX_MAXATTRS];	// ixAttrs opened for upkeep, or NULL
+
+   // record that page pageNo has freeBytes free
+   const Status fsmSet(const int pageNo, const int freeBytes);
+
+   // find a page with at least needed bytes free; NOSPACE if none
+   const Status fsmFind(const int needed, int& pageNo);
+
+   // point entry at the entrySize-byte entry of page pageNo in the
+   // page map on directory page dirPageNo, pinning its map page in
+   // cur. A missing map page is added, with every entry set to fill,
+   // if create is set; otherwise (or if pageNo is not tracked) entry
+   // is set to NULL.
+   const Status mapEntry(const int dirPageNo, const int entrySize,
+                         const int pageNo, const bool create,
+                         const char* fill, MapCursor& cur, char*& entry);
+
+   // unpin the map page held by cur
+   const Status mapRelease(MapCursor& cur);
+
+   // set the zone map entries of page pageNo from its records
+   const Status zmSummarize(const int pageNo, Page* page);
+
+   // make zones the zone map entries of page pageNo, or if widen is
+   // set, widen the entries to cover them
+   const Status zmStore(const int pageNo, const ZoneEntry zones[],
+                        const bool widen);
+
+   // record in the link map that nextPageNo follows pageNo
+   const Status zmLink(const int pageNo, const int nextPageNo);
+
+   // build the page directory from the page chain
+   const Status pdBuild();
+
+   // enter pageNo as data page k in the page directory
+   const Status pdSet(const int k, const int pageNo);
+
+   // look up data page k in the page directory, using cur
+   const Status pdGet(const int k, MapCursor& cur, int& pageNo);
+
+   // unlink the n data pages in pageNos, given in any order and all
+   // with no records, and dispose of them; no page is pinned
+   const Status dropPages(const int pageNos[], const int n);
+
+   // add the entries of the record rec at rid to the file's indexes,
+   // or remove them
+   const Status ixInsert(const Record & rec, const RID & rid);
+   const Status ixDelete(const Record & rec, const RID & rid);
+
+   // open index a of the header for upkeep, if it is not yet
+   const Status ixOpen(const int a);
 
 public:
 
@@ -58,8 +222,79 @@ public:
   // return number of records in file
   const int getRecCnt() const;
 
+  // return number of data pages in file
+  const int getPageCnt() const;
+
+  // copy the zone-mapped attributes into attrs, which has room for
+  // ZM_MAXATTRS, and return how many there are
+  const int getZoneMaps(ZoneAttr attrs[]) const;
+
   // given a RID, read record from file, returning pointer and length
   const Status getRecord(const RID &rid, Record & rec);
+
+  // keep a zone map on the attribute at offset, of type INTEGER or
+  // FLOAT, and build it from the pages of the file; ZONEMAPFULL if
+  // the file has ZM_MAXATTRS already
+  const Status buildZoneMap(const int offset, const Datatype type);
+
+  // copy the indexed attributes into attrs, which has room for
+  // IX_MAXATTRS, and return how many there are
+  const int getIndexes(IndexAttr attrs[]) const;
+
+  // keep an index of kind kind on the attribute at offset, of type
+  // type and length bytes, and build it from the records of the file;
+  // INDEXEXISTS if there is one, INDEXFULL if the file has
+  // IX_MAXATTRS already
+  const Status buildIndex(const int offset, const Datatype type,
+                          const int length, const IndexType kind);
+
+  // stop keeping the index on the attribute at offset and destroy its
+  // file; NOINDEX if there is none
+  const Status dropIndex(const int offset);
+};
+
+
+// The qualifying records of one page, as returned by
+// HeapFileScan::nextBatch. The data pointers point into the page,
+// which the scan keeps pinned until it moves on.
+const int MAXPAGERECS = (PAGESIZE - DPFIXED) / sizeof(slot_t) + 1;
+
+struct ScanBatch
+{
+  int    count;			// # records below
+  RID    rids[MAXPAGERECS];
+  Record recs[MAXPAGERECS];
+};
+
+
+// One attribute predicate of a scan filter: the attribute at offset
+// (length bytes, of type type) compared with the value at filter.
+struct ScanPred
+{
+  int      offset;
+  int      length;
+  Datatype type;
+  const char* filter;
+  Operator op;
+};
+
+const int MAXPREDS = 8;		// most predicates ANDed in one scan
+
+// A predicate as compiled by startScan: a comparator specialized for
+// its type and operator, with an INTEGER or FLOAT value copied out of
+// the filter. A STRING value is still referenced through sval.
+struct CompiledPred;
+typedef bool (*PredFn)(const char* rec, const CompiledPred& pred);
+
+struct CompiledPred
+{
+  PredFn fn;
+  Operator op;
+  int    offset;
+  int    length;
+  int    ival;
+  float  fval;
+  const char* sval;
 };
 
 
@@ -78,6 +313,16 @@ public:
                            const char* filter, 
                            const Operator op);
 
+    // filtered scan returning the records that satisfy all count
+    // predicates; STRING filter values must stay valid until the scan
+    // ends, INTEGER and FLOAT ones are copied
+    const Status startScan(const ScanPred preds[], const int count);
+
+    // limit the scan to data pages [fromPage, toPage), numbered in
+    // chain order from 0, and restart it; toPage -1 means to the end
+    // of the file
+    const Status setRange(const int fromPage, const int toPage);
+
     const Status endScan(); // terminate the scan
     const Status markScan(); // save current position of scan
     const Status resetScan(); // reset scan to last marked location
@@ -85,21 +330,56 @@ public:
     // return RID of next record that satisfies the scan 
     const Status scanNext(RID& outRid);
 
+    // return the rest of the records that satisfy the scan on the
+    // current page, or on the next page that has any; FILEEOF at
+    // the end. Afterwards the current record is the last one looked
+    // at, so scanNext and nextBatch can be mixed.
+    const Status nextBatch(ScanBatch& batch);
+
     // read current record, returning pointer and length
     const Status getRecord(Record & rec);
 
     // delete current record 
     const Status deleteRecord();
 
+    // like nextBatch, but only the records at rids[next..n), which
+    // are sorted by page, are looked at: the matches among those on
+    // the next page they name go into batch. next is advanced past
+    // the RIDs looked at.
+    const Status nextBatch(const RID rids[], const int n, int& next,
+                           ScanBatch& batch);
+
+    // delete every record the scan has yet to return, a page at a
+    // time, and drop the pages that are left empty; count is set to
+    // the number deleted. Ends the scan.
+    const Status deleteMatches(int& count);
+
+    // likewise for the matches among the records at rids, which are
+    // sorted by page
+    const Status deleteMatches(const RID rids[], const int n, int& count);
+
     // marks current page of scan dirty
     const Status markDirty();
 
 private:
-    int   offset;            // byte offset of filter attribute
-    int   length;            // length of filter attribute
-    Datatype type;           // datatype of filter attribute
-    const char* filter;      // comparison value of filter
-    Operator op;             // comparison operator of filter
+    CompiledPred preds[MAXPREDS]; // filter, ANDed
+    int   predCnt;           // # predicates; 0 means no filtering
+    int   minRecLen;         // records shorter than this never match
+    int   vecPred;           // INTEGER or FLOAT predicate nextBatch
+                             // evaluates a page at a time, or -1
+    Datatype vecType;        // its type
+    Operator vecOp;          // and operator
+
+    int   zonePreds[MAXPREDS]; // predicates with a zone map
+    int   zoneAttrs[MAXPREDS]; // and the zone-mapped attribute of each
+    int   zoneCnt;
+    MapCursor zoneCur[MAXPREDS];
+    MapCursor linkCur;
+
+    int   rangeFrom;         // data pages [rangeFrom, rangeTo) are
+    int   rangeTo;           // scanned; rangeTo -1 means the whole chain
+    int   curOrd;            // position of curPageNo if rangeTo >= 0
+    MapCursor dirCur;
 
      // The following variables are used to preserve the state
     // of the scan when the method markScan() is invoked.
@@ -107,8 +387,31 @@ private:
     // scan to be rolled back to the following
     int   markedPageNo;	// page number of pinned page
     RID   markedRec;         // rid of last record returned
+    int   markedOrd;         // and position of the page
+
+    bool  seqHinted;         // told bufMgr this file is scanned sequentially
 
     const bool matchRec(const Record & rec) const;
+
+    // set pageNo to the first page of the scan, or the one after
+    // the current page; -1 at the end
+    const Status firstPage(int& pageNo);
+    const Status nextPage(int& pageNo);
+
+    // set pageNo to page curOrd of the range, -1 past its end
+    const Status rangePage(int& pageNo);
+
+    // move pageNo past pages whose zone maps show they hold no
+    // matches, without reading them
+    const Status skipPages(int& pageNo);
+
+    // deleteMatches on the records at rids, or on the rest of the
+    // scan if rids is NULL
+    const Status deleteBatches(const RID rids[], const int n, int& count);
+
+    // add the matches on the current page after curRec to batch,
+    // evaluating predicate vecPred over the whole page at once
+    void filterPage(ScanBatch& batch);
 };
 
 
@@ -123,6 +426,58 @@ public:
 
     // insert record into file, returning its RID
     const Status insertRecord(const Record & rec, RID& outRid); 
+
+    // insert count records, filling each page before moving on;
+    // their RIDs are returned in outRids unless it is NULL. Stops at
+    // the first record that cannot be inserted; count is set to the
+    // number inserted.
+    const Status insertRecords(const Record recs[], int& count,
+                               RID outRids[] = NULL);
+
+private:
+    // leave the full current page for one with needed bytes free,
+    // found through the free-space map or added at the end
+    const Status nextFreePage(const int needed);
+
+    // values inserted on the current page, not yet in its zone maps
+    ZoneEntry zones[ZM_MAXATTRS];
+    bool  zonesPending;
+    const Status flushZones();
+};
+
+
+// Collects fixed-length tuples produced by a query operator and adds
+// them to the result relation a page's worth at a time. Build each
+// tuple in the space returned by tuple(), then call append().
+
+class ResultWriter
+{
+public:
+    ResultWriter(const string & relation, const int recLen, Status & status);
+
+    // flush and close the relation
+    ~ResultWriter();
+
+    // space for the next tuple
+    char* tuple() { return buf + used * recLen; }
+
+    // add the tuple built in tuple()
+    const Status append();
+
+    // write out the tuples collected so far
+    const Status flush();
+
+    // number of tuples appended
+    const int count() const { return total; }
+
+private:
+    InsertFileScan* file;
+    int   recLen;       // length of every tuple
+    int   batch;        // tuples per flush
+    int   used;         // tuples in buf
+    int   total;
+    char* buf;
+    Record* recs;
 };
 
 #endif
@@ -0,0 +1,153 @@
+#ifndef IOQUEUE_H
+#define IOQUEUE_H
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <pthread.h>
+#include "error.h"
+
+// define if debug output wanted
+//#define DEBUGIOQ
+
+#define IOREQ_MAXPAGES	128	// most pages transferred by one request
+#define IOQUEUE_DEPTH	64	// requests in flight per queue
+#define IOTHREADS	4	// workers of the thread pool backend
+
+enum IOBackendType { IO_AUTO, IO_URING, IO_THREADS, IO_SYNC };
+
+// maps "auto", "uring", "threads" and "sync" to a backend type;
+// returns BADIOBACKEND for anything else
+const Status parseIOBackend(const char* name, IOBackendType& type);
+
+
+// One vectored read or write of consecutive pages, filled in with
+// File::prepareIO. The request must stay put until it is complete.
+
+struct IORequest {
+  int		fd;
+  off_t		offset;
+  int		count;			// # entries used in iov
+  bool		write;
+  struct iovec	iov[IOREQ_MAXPAGES];
+
+  // set when the request completes
+  ssize_t	result;			// bytes transferred, or -errno
+  bool		done;
+
+  IORequest*	next;			// used by the backends
+};
+
+
+// Interface of an asynchronous I/O backend. Any number of requests
+// may be submitted before waiting for them; requests complete in any
+// order. Several threads may use one queue at the same time.
+
+class IOQueue {
+public:
+  virtual ~IOQueue() {}
+
+  virtual const char* name() const = 0;
+
+  // start req; it completes (req->done) some time later. Blocks if
+  // the queue is full.
+  virtual const Status submit(IORequest* req) = 0;
+
+  // block until req has completed
+  virtual void wait(IORequest* req) = 0;
+
+  // true if req has completed; never blocks
+  virtual bool poll(IORequest* req) = 0;
+};
+
+// Create a queue of the given type. IO_AUTO (and IO_URING where the
+// kernel does not support it) use io_uring if possible and fall back
+// to the thread pool.
+IOQueue* newIOQueue(const IOBackendType type);
+
+
+// Requests are carried out right away by submit. Used when asked
+// for, and by the thread pool if it cannot start its threads.
+
+class SyncIOQueue : public IOQueue {
+public:
+  const char* name() const { return "sync"; }
+  const Status submit(IORequest* req);
+  void wait(IORequest* req) {}
+  bool poll(IORequest* req) { return true; }
+};
+
+
+// A pool of threads doing blocking preadv/pwritev calls. Works
+// everywhere; keeps up to IOTHREADS requests in flight.
+
+class ThreadIOQueue : public IOQueue {
+public:
+  ThreadIOQueue();
+  ~ThreadIOQueue();
+
+  const char* name() const { return "threads"; }
+  const Status submit(IORequest* req);
+  void wait(IORequest* req);
+  bool poll(IORequest* req);
+
+  bool started() const { return numThreads > 0; }
+
+private:
+  pthread_t	threads[IOTHREADS];
+  int		numThreads;
+  pthread_mutex_t latch;		// protects everything below
+  pthread_cond_t workCond;		// signalled when work is queued
+  pthread_cond_t doneCond;		// broadcast when a request completes
+  IORequest*	head;			// FIFO of queued requests
+  IORequest*	tail;
+  bool		stop;
+
+  static void* worker(void* arg);
+};
+
+
+// Linux io_uring, driven with the raw system calls (no liburing).
+// Up to IOQUEUE_DEPTH requests are handed to the kernel at once.
+
+class UringIOQueue : public IOQueue {
+public:
+  UringIOQueue();
+  ~UringIOQueue();
+
+  const char* name() const { return "uring"; }
+  const Status submit(IORequest* req);
+  void wait(IORequest* req);
+  bool poll(IORequest* req);
+
+  bool started() const { return ringFd >= 0; }
+
+private:
+  int		ringFd;
+  void*		sqRing;			// mapped rings and entries
+  size_t	sqRingSize;
+  void*		cqRing;
+  size_t	cqRingSize;
+  void*		sqes;
+  size_t	sqesSize;
+
+  // pointers into the mapped rings
+  unsigned*	sqHead;
+  unsigned*	sqTail;
+  unsigned*	sqMask;
+  unsigned*	sqArray;
+  unsigned*	cqHead;
+  unsigned*	cqTail;
+  unsigned*	cqMask;
+  void*		cqes;
+
+  unsigned	sqEntries;
+  int		inFlight;		// submitted, not yet reaped
+  bool		reaping;		// a thread waits in the kernel
+  pthread_mutex_t latch;		// protects the rings and the above
+  pthread_cond_t doneCond;		// broadcast after reaping
+
+  void reap();				// collect completions, latch held
+  void enter(const unsigned toSubmit, const unsigned minComplete);
+};
+
+#endif
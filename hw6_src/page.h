@@ -22,29 +22,59 @@ struct slot_t {
         short	length;  // equals -1 if slot is not in use
 };
 
-const unsigned PAGESIZE = 1024;
+// The page size is picked at compile time with PAGEBYTES in the
+// Makefile. Offsets within a page are shorts, so 16K is the limit.
+#ifndef PAGEBYTES
+#define PAGEBYTES 1024
+#endif
+#if PAGEBYTES != 1024 && PAGEBYTES != 4096 && PAGEBYTES != 8192 && PAGEBYTES != 16384
+#error "PAGEBYTES must be 1024, 4096, 8192 or 16384"
+#endif
+
+const unsigned PAGESIZE = PAGEBYTES;
 const unsigned DPFIXED= sizeof(slot_t)+4*sizeof(short)+2*sizeof(int);
 const unsigned PAGEDATASIZE = PAGESIZE-DPFIXED+sizeof(slot_t);
 // size of the data area of a page
 
-// Class definition for a minirel data page.   
-// The design assumes that records are kept compacted when
-// deletions are performed. Notice, however, that the slot
-// array cannot be compacted.  Notice, this class does not keep
-// the records align, relying instead on upper levels to take
-// care of non-aligned attributes
+// Class definition for a minirel data page.
+// Records are added from the front of data[] and the slot array grows
+// backwards from its end. A delete only marks the record's slot free
+// and puts it on the page's free-slot list, leaving a hole in data[];
+// the holes are squeezed out when an insert needs more contiguous
+// space than there is between the records and the slot array. Pages
+// written before the free-slot list are converted the first time one
+// of them is updated. Notice, this class does not keep the records
+// aligned, relying instead on upper levels to take care of non-aligned
+// attributes
+
+// freeSlots of a page with a free-slot list is PAGEV2 | (first free
+// slot + 1), or just PAGEV2 if there are no free slots; free slots
+// hold the next one + 1 in their offset. Older pages never set the
+// field, so whatever is there only counts as the tag if the head it
+// names is a free slot of the page.
+const short PAGEV2 = 0x4000;
+const short SLOTMASK = 0x1fff;
 
 class Page {
 private:
-    char 	data[PAGESIZE - DPFIXED]; 
-    slot_t 	slot[1]; // first element of slot array - grows backwards!
-    short	slotCnt; // number of slots in use;
+    char 	data[PAGEDATASIZE]; // records, then the slot array
+    short	slotCnt; // minus the number of slots
     short	freePtr; // offset of first free byte in data[]
     short	freeSpace; // number of bytes free in data[]
-    short	dummy;	// for alignment purposes
+    short	freeSlots; // free-slot list head, see above
     int		nextPage; // forwards pointer
     int		curPage;  // page number of current pointer
 
+    // slot i; slot 0 is at the very end of data[]
+    slot_t* slotAt(const int i)
+      { return (slot_t*)&data[PAGEDATASIZE] - 1 - i; }
+    const slot_t* slotAt(const int i) const
+      { return (const slot_t*)&data[PAGEDATASIZE] - 1 - i; }
+
+    bool hasFreeList() const;  // freeSlots is a valid PAGEV2 tag
+    void upgrade();  // give an older page a free-slot list
+    void compact();  // squeeze out the holes left by deletes
+
 public:
     void init(const int pageNo); // initialize a new page
     void dumpPage() const;       // dump contents of a page
@@ -69,6 +99,14 @@ public:
 
     // returns reference to record with RID rid
     const Status getRecord(const RID & rid, Record & rec);
+
+    // copies the 4 bytes at offset of each record after slot afterSlot
+    // (-1 for all records) that is at least minLen long into vals, and
+    // its slot number into slotNos. Returns the number copied; lastSlot
+    // is set to the last record looked at, or -1 if there was none.
+    const int gatherAttr(const int afterSlot, const int offset,
+                         const int minLen, void* vals, int slotNos[],
+                         int& lastSlot) const;
 };
 
 #endif
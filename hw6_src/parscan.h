@@ -0,0 +1,34 @@
+#ifndef PARSCAN_H
+#define PARSCAN_H
+
+#include "catalog.h"
+
+// most worker threads a parallel scan will use
+const int MAXSCANTHREADS = 64;
+
+// data pages a worker scans at a time
+const int MORSEL_PAGES = 16;
+
+
+// Selects the records of relation that satisfy preds and adds their
+// projections to result, like ScanSelect. The data pages are handed
+// out MORSEL_PAGES at a time to threads workers, which filter and
+// project them; the tuples are added to result in the order their
+// morsels finish, or in file order if ordered is set. A relation with
+// more pages than its page directory tracks is left to ScanSelect.
+//
+// Returns:
+// 	OK on success
+// 	an error code otherwise
+
+const Status ParallelSelect(const string & result,
+			    const int projCnt,
+			    const AttrDesc projNames[],
+			    const string & relation,
+			    const ScanPred preds[],
+			    const int predCnt,
+			    const int recordlen,
+			    const int threads,
+			    const bool ordered);
+
+#endif
@@ -65,7 +65,11 @@ typedef enum {
     N_ATTRTYPE,
     N_VALUE,
     N_LIST,
-    N_ALIAS
+    N_ALIAS,
+    N_STATS,
+    N_ZONEMAP,
+    N_VACUUM,
+    N_HASHINDEX
 } NODEKIND;
 
 
@@ -137,6 +141,11 @@ typedef struct node {
 	    char *relname;
 	} HELP;
 
+	// stats node */
+	struct {
+	    int reset;
+	} STATS;
+
 	// select node */
 	struct {
 	    struct node *selattr;
@@ -223,6 +232,10 @@ NODE *drop_node(char *relname, char *attrname);
 NODE *load_node(char *relname, char *filename);
 NODE *print_node(char *relname);
 NODE *help_node(char *relname);
+NODE *stats_node(int reset);
+NODE *zonemap_node(char *relname, char *attrname);
+NODE *vacuum_node(char *relname, char *attrname);
+NODE *hashindex_node(char *relname, char *attrname);
 NODE *select_node(NODE *selattr, int op, NODE *value);
 NODE *join_node(NODE *joinattr1, int op, NODE *joinattr2);
 NODE *qualattr_node(char *relname, char *attrname);
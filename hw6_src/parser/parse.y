@@ -72,6 +72,12 @@ static NODE *parse_tree;                // root of parse tree
 		T_QSTRING
 		T_SHELL_CMD
 
+%token		RW_STATS
+		RW_RESET
+		RW_ZONEMAP
+		RW_VACUUM
+		RW_HASH
+
 %type	<ival>	op
 
 %type	<sval>	opt_into_relname
@@ -93,9 +99,13 @@ static NODE *parse_tree;                // root of parse tree
 		print
 		help
 		quit
+		stats
+		zonemap
+		vacuum
 		opt_primary_attr
 		opt_where
 		qual
+		conjunction
 		selection
 		join
 		non_mt_qualattr_list
@@ -156,6 +166,9 @@ command
 	| print
 	| help
 	| quit
+	| stats
+	| zonemap
+	| vacuum
 	| nothing
 	{
 		$$ = NULL;
@@ -274,6 +287,10 @@ build
 	{
 		$$ = build_node($2, $4, 0);
 	}
+	| RW_BUILD string '(' string ')' RW_HASH
+	{
+		$$ = hashindex_node($2, $4);
+	}
 	;
 
 /*
@@ -316,6 +333,35 @@ help
 	}
 	;
 
+stats
+	: RW_STATS
+	{
+		$$ = stats_node(0);
+	}
+	| RW_STATS RW_RESET
+	{
+		$$ = stats_node(1);
+	}
+	;
+
+zonemap
+	: RW_ZONEMAP string '(' string ')'
+	{
+		$$ = zonemap_node($2, $4);
+	}
+	;
+
+vacuum
+	: RW_VACUUM string
+	{
+		$$ = vacuum_node($2, NULL);
+	}
+	| RW_VACUUM string '(' string ')'
+	{
+		$$ = vacuum_node($2, $4);
+	}
+	;
+
 quit
 	: RW_QUIT ';'
 	{
@@ -369,9 +415,24 @@ opt_where
 
 qual
 	: selection
+	| selection RW_AND conjunction
+	{
+		$$ = prepend($1, $3);
+	}
 	| join
 	;
 
+conjunction
+	: selection RW_AND conjunction
+	{
+		$$ = prepend($1, $3);
+	}
+	| selection
+	{
+		$$ = list_node($1);
+	}
+	;
+
 selection
 	: qualattr op value
 	{
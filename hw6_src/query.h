@@ -1,6 +1,7 @@
 #ifndef QUERY_H
 #define QUERY_H
 
+#include <vector>
 #include "heapfile.h"
 
 enum JoinType {NLJoin, SMJoin, HashJoin};
@@ -10,12 +11,16 @@ enum JoinType {NLJoin, SMJoin, HashJoin};
 //
 
 
+// The where clause of a select or delete is predCnt predicates ANDed
+// together: preds[i].attrName ops[i] preds[i].attrValue, with the
+// value in string form.
+
 const Status QU_Select(const string & result, 
 		       const int projCnt, 
 		       const attrInfo projNames[],
-		       const attrInfo *attr, 
-		       const Operator op, 
-		       const char *attrValue);
+		       const int predCnt,
+		       const attrInfo preds[],
+		       const Operator ops[]);
 
 const Status QU_Join(const string & result, 
 		     const int projCnt, 
@@ -29,9 +34,34 @@ const Status QU_Insert(const string & relation,
 		       const attrInfo attrList[]);
 
 const Status QU_Delete(const string & relation, 
-		       const string & attrName, 
-		       const Operator op,
-		       const Datatype type, 
-		       const char *attrValue);
+		       const int predCnt,
+		       const attrInfo preds[],
+		       const Operator ops[]);
+
+// Turns such predicates on relation into scan predicates. Values are
+// converted to the type of their attribute; INTEGER and FLOAT ones
+// are stored in vals, STRING ones are referenced in place.
+
+typedef union { int i; float f; } PredValue;
+
+const Status QU_ScanPreds(const string & relation,
+			  const int predCnt,
+			  const attrInfo preds[],
+			  const Operator ops[],
+			  ScanPred scanPreds[],
+			  PredValue vals[]);
+
+// If one of the scan predicates, other than NE, is on an attribute of
+// relation with an index that serves it, sets used and looks up the
+// RIDs of the records within the bounds all the predicates on that
+// attribute put on it, sorted by page. A hash index serves only EQ;
+// EQ predicates are preferred, on a hash index first. The records
+// must still be checked against the predicates.
+
+const Status QU_IndexRids(const string & relation,
+			  const ScanPred preds[],
+			  const int predCnt,
+			  vector<RID> & rids,
+			  bool & used);
 
 #endif
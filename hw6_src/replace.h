@@ -0,0 +1,211 @@
+#ifndef REPLACE_H
+#define REPLACE_H
+
+#include <set>
+#include <utility>
+#include "buf.h"
+
+// define if debug output wanted
+//#define DEBUGREPL
+
+// maps "clock", "2q" and "clockpro" to a policy type; returns
+// BADREPLPOLICY for anything else
+const Status parseReplPolicy(const char* name, ReplPolicyType& type);
+
+
+// Interface between BufMgr and a page replacement policy. The buffer
+// manager reports every page that enters, is referenced in, or leaves
+// a frame; the policy picks the frame to reuse on a miss. Policies may
+// look at (but not change) the frame descriptors through the helpers
+// below.
+
+class ReplPolicy {
+public:
+  ReplPolicy(BufDesc* table, const int bufs) : bufTable(table), numBufs(bufs) {}
+  virtual ~ReplPolicy() {}
+
+  virtual const char* name() const = 0;
+
+  // frame was just filled with a page; referenced is false for pages
+  // that were read ahead rather than asked for
+  virtual void loaded(const int frame, const bool referenced) = 0;
+
+  // page in frame was asked for again while resident
+  virtual void accessed(const int frame) = 0;
+
+  // true if accessed() may be called without holding the buffer
+  // manager's pool latch; all other calls are made with it held
+  virtual bool latchFreeAccess() const { return false; }
+
+  // page in frame is about to be replaced (descriptor still describes it)
+  virtual void evicted(const int frame) = 0;
+
+  // frame was emptied without being replaced (disposePage, flushFile)
+  virtual void removed(const int frame) = 0;
+
+  // choose a frame to reuse: either an invalid one or an unpinned one
+  // whose page may be evicted.  Returns BUFFEREXCEEDED if every frame
+  // is pinned.
+  virtual const Status pickVictim(int& frame) = 0;
+
+protected:
+  BufDesc*	bufTable;
+  int		numBufs;
+
+  bool isValid(const int frame) const { return bufTable[frame].valid; }
+  bool isPinned(const int frame) const
+  {
+    return __atomic_load_n(&bufTable[frame].pinCnt, __ATOMIC_ACQUIRE) > 0;
+  }
+  bool isPrefetched(const int frame) const
+  {
+    return __atomic_load_n(&bufTable[frame].prefetched, __ATOMIC_RELAXED);
+  }
+  bool& refbit(const int frame) { return bufTable[frame].refbit; }
+  const File* fileOf(const int frame) const { return bufTable[frame].file; }
+  int pageOf(const int frame) const { return bufTable[frame].pageNo; }
+
+  bool isDirty(const int frame) const
+  {
+    return __atomic_load_n(&bufTable[frame].dirty, __ATOMIC_RELAXED);
+  }
+
+  // frames holding read-ahead pages nobody used yet, and dirty pages
+  // the background writer has not cleaned yet, are left alone on the
+  // first turn over the pool
+  bool evictable(const int frame, const bool firstTurn) const
+  {
+    return !isPinned(frame) &&
+      !(firstTurn && (isPrefetched(frame) || isDirty(frame)));
+  }
+};
+
+ReplPolicy* newReplPolicy(const ReplPolicyType type, BufDesc* table,
+			  const int bufs);
+
+
+// Keys of recently evicted pages, remembered in FIFO order so that a
+// policy can recognize a page that comes back soon after it was thrown
+// out.  Used by 2Q (A1out) and CLOCK-Pro (non-resident test pages).
+
+class GhostList {
+public:
+  GhostList(const int capacity);
+  ~GhostList();
+
+  // remember (file, pageNo); returns true if the oldest entry was
+  // dropped to make room
+  bool add(const File* file, const int pageNo);
+
+  // forget (file, pageNo); returns true if it was remembered
+  bool remove(const File* file, const int pageNo);
+
+private:
+  typedef std::pair<const File*, int> Key;
+
+  int		capacity;
+  int		head;           // index of oldest entry in ring
+  int		count;          // # entries in ring (some may be stale)
+  Key*		ring;           // entries in FIFO order
+  std::set<Key> members;        // live entries
+};
+
+
+// The original single-bit clock (second chance).
+
+class ClockPolicy : public ReplPolicy {
+public:
+  ClockPolicy(BufDesc* table, const int bufs);
+
+  const char* name() const { return "clock"; }
+  void loaded(const int frame, const bool referenced);
+  void accessed(const int frame);
+  bool latchFreeAccess() const { return true; }
+  void evicted(const int frame) {}
+  void removed(const int frame) {}
+  const Status pickVictim(int& frame);
+
+private:
+  unsigned int clockHand;
+
+  void advanceClock()
+  {
+	clockHand = (clockHand + 1) % numBufs;
+  }
+};
+
+
+// 2Q (Johnson & Shasha, VLDB '94).  Pages referenced once live in the
+// FIFO A1in and are evicted from there; only a page referenced again
+// after falling out of A1in (found in the ghost list A1out) enters the
+// LRU list Am.  A sequential scan therefore cycles through A1in and
+// cannot push the hot pages kept in Am out of the pool.
+
+class TwoQPolicy : public ReplPolicy {
+public:
+  TwoQPolicy(BufDesc* table, const int bufs);
+  ~TwoQPolicy();
+
+  const char* name() const { return "2q"; }
+  void loaded(const int frame, const bool referenced);
+  void accessed(const int frame);
+  void evicted(const int frame);
+  void removed(const int frame);
+  const Status pickVictim(int& frame);
+
+private:
+  enum { NOLIST = 0, A1IN, AM };
+
+  struct List {
+    int head;                   // most recently inserted / used
+    int tail;                   // next candidate for eviction
+    int size;
+  };
+
+  int*		prev;           // doubly linked lists threaded
+  int*		next;           //   through the frame numbers
+  int*		onList;         // list each frame is on
+  List		a1in;
+  List		am;
+  int		kin;            // target size of A1in
+  GhostList	a1out;
+
+  void unlink(const int frame);
+  void pushHead(List& list, const int which, const int frame);
+  int  victimFrom(List& list, const bool firstTurn);
+};
+
+
+// CLOCK-Pro (Jiang, Chen & Zhang, USENIX '05), with the non-resident
+// cold pages kept in a ghost list instead of on the clock.  Resident
+// pages are hot or cold; a cold page that is referenced again during
+// its test period is promoted to hot, and a page that returns while
+// its key is still in the ghost list is loaded hot.  The share of the
+// pool given to cold pages adapts to how often such re-references
+// happen.
+
+class ClockProPolicy : public ReplPolicy {
+public:
+  ClockProPolicy(BufDesc* table, const int bufs);
+  ~ClockProPolicy();
+
+  const char* name() const { return "clockpro"; }
+  void loaded(const int frame, const bool referenced);
+  void accessed(const int frame);
+  void evicted(const int frame);
+  void removed(const int frame);
+  const Status pickVictim(int& frame);
+
+private:
+  bool*		hot;            // page in frame is hot
+  bool*		test;           // cold page in frame is in its test period
+  int		hotCnt;         // # hot resident pages
+  int		coldTarget;     // adaptive target # of cold resident pages
+  unsigned int	handCold;
+  unsigned int	handHot;
+  GhostList	nonResident;
+
+  bool runHandHot();
+};
+
+#endif
@@ -27,6 +27,21 @@ const Status UT_Load(const string & relation,
 
 const Status UT_Print(string relation);
 
+const Status UT_Stats(const bool reset);
+
+const Status UT_BuildZoneMap(const string & relation,
+			     const string & attrName);
+
+const Status UT_Vacuum(const string & relation,
+		       const string & attrName);
+
+const Status UT_BuildIndex(const string & relation,
+			   const string & attrName,
+			   const bool hash);
+
+const Status UT_DropIndex(const string & relation,
+			  const string & attrName);
+
 void   UT_Quit(void);
 
 #endif